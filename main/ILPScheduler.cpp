@@ -1,10 +1,11 @@
 #include "ILPScheduler.h"
 #include "Scheduler.h"
 #include <thread>
+#include <algorithm>
 #include <iostream>
 
 ILPScheduler::ILPScheduler(Graph* graph, int andLimit, int orLimit, int notLimit)
-    : graph(graph), andLimit(andLimit), orLimit(orLimit), notLimit(notLimit), latency(0) {}
+    : graph(graph), andLimit(andLimit), orLimit(orLimit), notLimit(notLimit), latency(0), modelNames(false), horizon(0) {}
 
 int ILPScheduler::getOperationType(Node* node) const {
     if (node->type == "AND") return 0;
@@ -13,6 +14,205 @@ int ILPScheduler::getOperationType(Node* node) const {
     return -1; // INPUT or OUTPUT
 }
 
+void ILPScheduler::buildModel(GRBModel& model, int maxLatency) {
+    // Need to schedule operation nodes (AND, OR, NOT)
+    operationNodes.clear();
+    operationTypes.clear();
+    std::map<Node*, int> opIndex;
+    for (auto& pair : graph->nodes) {
+        Node* node = pair.second;
+        int opType = getOperationType(node);
+        if (opType != -1) {
+            opIndex[node] = static_cast<int>(operationNodes.size());
+            operationNodes.push_back(node);
+            operationTypes.push_back(opType);
+        }
+    }
+    int numOps = static_cast<int>(operationNodes.size());
+    horizon = maxLatency;
+
+    // Variables: x_i_t = 1 if node i starts at time t, added as one unnamed block
+    GRBVar* xVars = model.addVars(numOps * horizon, GRB_BINARY);
+    x.assign(xVars, xVars + numOps * horizon);
+    delete[] xVars;
+
+    // Latency variable
+    latencyVar = model.addVar(1, maxLatency, 0, GRB_INTEGER, "latency");
+
+    std::vector<int> typeOps[3];
+    for (int i = 0; i < numOps; ++i) {
+        typeOps[operationTypes[i]].push_back(i);
+    }
+
+    // Shared coefficient rows so every expression is filled with addTerms in one call
+    size_t maxTerms = horizon;
+    for (int type = 0; type < 3; ++type) {
+        maxTerms = std::max(maxTerms, typeOps[type].size());
+    }
+    std::vector<double> ones(maxTerms, 1.0), negOnes(horizon, -1.0), negTimes(horizon);
+    for (int t = 1; t <= horizon; ++t) {
+        negTimes[t - 1] = -t;
+    }
+    const double one = 1.0;
+
+    // Rows are buffered and handed to Gurobi in batches of bounded size, so only
+    // one batch is ever duplicated between this buffer and Gurobi's own copy
+    std::vector<GRBLinExpr> lhs;
+    std::vector<char> senses;
+    std::vector<double> rhs;
+    size_t batchRows = 0, batchTerms = 0;
+    auto flushRows = [&]() {
+        if (batchRows == 0) return;
+        GRBConstr* constrs = model.addConstrs(lhs.data(), senses.data(), rhs.data(), nullptr,
+                                              static_cast<int>(batchRows));
+        delete[] constrs;
+        batchRows = 0;
+        batchTerms = 0;
+    };
+    auto addRow = [&](char sense, double value, size_t terms) -> GRBLinExpr& {
+        if (batchTerms + terms > maxBatchTerms) {
+            flushRows();
+        }
+        if (batchRows == lhs.size()) {
+            lhs.emplace_back();
+            senses.push_back(sense);
+            rhs.push_back(value);
+        } else {
+            lhs[batchRows].clear(); // Reuse the expression left over from an earlier batch
+            senses[batchRows] = sense;
+            rhs[batchRows] = value;
+        }
+        batchTerms += terms;
+        return lhs[batchRows++];
+    };
+
+    // Constraints (nameModel walks the same loops in the same order):
+
+    // 1. Each operation must be scheduled exactly once
+    for (int i = 0; i < numOps; ++i) {
+        addRow(GRB_EQUAL, 1, horizon).addTerms(ones.data(), &x[i * horizon], horizon);
+    }
+
+    // 2. Dependency Constraints: x_node_t - sum_{tp < t} x_pred_tp <= 0
+    for (int i = 0; i < numOps; ++i) {
+        Node* node = operationNodes[i];
+        for (Node* pred : node->inputs) {
+            auto it = opIndex.find(pred);
+            if (it == opIndex.end()) {
+                // pred is INPUT node
+                // Node cannot start before time 1
+                // No need to add constraint since x[node][t] is defined for t >= 1
+                continue;
+            }
+            int p = it->second;
+            for (int t = 1; t <= horizon; ++t) {
+                GRBLinExpr& expr = addRow(GRB_LESS_EQUAL, 0, t);
+                expr.addTerms(&one, &x[i * horizon + (t - 1)], 1);
+                expr.addTerms(negOnes.data(), &x[p * horizon], t - 1);
+            }
+        }
+    }
+
+    // 3. Resource Constraints
+    const int limits[3] = { andLimit, orLimit, notLimit };
+    std::vector<GRBVar> column;
+    for (int t = 1; t <= horizon; ++t) {
+        for (int type = 0; type < 3; ++type) {
+            column.clear();
+            for (int i : typeOps[type]) {
+                column.push_back(x[i * horizon + (t - 1)]);
+            }
+            addRow(GRB_LESS_EQUAL, limits[type], column.size())
+                .addTerms(ones.data(), column.data(), static_cast<int>(column.size()));
+        }
+    }
+
+    // 4. Latency Constraints: latency - sum_t t * x_node_t >= 0
+    for (int i = 0; i < numOps; ++i) {
+        GRBLinExpr& expr = addRow(GRB_GREATER_EQUAL, 0, horizon + 1);
+        expr.addTerms(&one, &latencyVar, 1);
+        expr.addTerms(negTimes.data(), &x[i * horizon], horizon);
+    }
+
+    // For OUTPUT nodes
+    for (Node* node : graph->outputs) {
+        for (Node* pred : node->inputs) {
+            auto it = opIndex.find(pred);
+            if (it == opIndex.end()) {
+                // pred is INPUT node
+                addRow(GRB_GREATER_EQUAL, 1, 1).addTerms(&one, &latencyVar, 1);
+            } else {
+                GRBLinExpr& expr = addRow(GRB_GREATER_EQUAL, 0, horizon + 1);
+                expr.addTerms(&one, &latencyVar, 1);
+                expr.addTerms(negTimes.data(), &x[it->second * horizon], horizon);
+            }
+        }
+    }
+    flushRows();
+
+    // Objective: Minimize latency
+    model.setObjective(GRBLinExpr(latencyVar), GRB_MINIMIZE);
+}
+
+void ILPScheduler::nameModel(GRBModel& model) const {
+    std::vector<std::string> names;
+    names.reserve(horizon);
+    for (size_t i = 0; i < operationNodes.size(); ++i) {
+        names.clear();
+        for (int t = 1; t <= horizon; ++t) {
+            names.push_back("x_" + operationNodes[i]->name + "_" + std::to_string(t));
+        }
+        model.set(GRB_StringAttr_VarName, &x[i * horizon], names.data(), horizon);
+    }
+
+    // Constraint i gets the i-th name produced by walking buildModel's loops
+    model.update();
+    GRBConstr* constrs = model.getConstrs();
+    int named = 0;
+    names.clear();
+    auto addName = [&](const std::string& name) {
+        names.push_back(name);
+        if (names.size() == maxBatchNames) {
+            model.set(GRB_StringAttr_ConstrName, constrs + named, names.data(), static_cast<int>(names.size()));
+            named += static_cast<int>(names.size());
+            names.clear();
+        }
+    };
+
+    for (Node* node : operationNodes) {
+        addName("sched_once_" + node->name);
+    }
+    for (Node* node : operationNodes) {
+        for (Node* pred : node->inputs) {
+            if (getOperationType(pred) == -1) continue;
+            for (int t = 1; t <= horizon; ++t) {
+                addName("dep_" + pred->name + "_" + node->name + "_t" + std::to_string(t));
+            }
+        }
+    }
+    for (int t = 1; t <= horizon; ++t) {
+        addName("and_limit_t" + std::to_string(t));
+        addName("or_limit_t" + std::to_string(t));
+        addName("not_limit_t" + std::to_string(t));
+    }
+    for (Node* node : operationNodes) {
+        addName("latency_constr_" + node->name);
+    }
+    for (Node* node : graph->outputs) {
+        for (Node* pred : node->inputs) {
+            if (getOperationType(pred) == -1) {
+                addName("output_dep_input_" + pred->name + "_" + node->name);
+            } else {
+                addName("output_dep_" + pred->name + "_" + node->name);
+            }
+        }
+    }
+    if (!names.empty()) {
+        model.set(GRB_StringAttr_ConstrName, constrs + named, names.data(), static_cast<int>(names.size()));
+    }
+    delete[] constrs;
+}
+
 void ILPScheduler::exactSchedule() {
     try {
         // Determine number of threads
@@ -39,118 +239,22 @@ void ILPScheduler::exactSchedule() {
         heuristicScheduler.heuristicSchedule();
         int heuristicLatency = heuristicScheduler.getLatency();
 
-        // Need to schedule operation nodes (AND, OR, NOT)
-        std::vector<Node*> operationNodes;
-        for (auto& pair : graph->nodes) {
-            Node* node = pair.second;
-            int opType = getOperationType(node);
-            if (opType != -1) {
-                operationNodes.push_back(node);
-            }
-        }
-
         int maxLatency = heuristicLatency;
-
-        // Variables: x_i_t = 1 if node i starts at time t
-        std::map<Node*, std::vector<GRBVar>> x;
-        for (Node* node : operationNodes) {
-            std::vector<GRBVar> varList;
-            for (int t = 1; t <= maxLatency; ++t) {
-                varList.push_back(model.addVar(0, 1, 0, GRB_BINARY, "x_" + node->name + "_" + std::to_string(t)));
-            }
-            x[node] = varList;
+        buildModel(model, maxLatency);
+        if (modelNames) {
+            nameModel(model);
+            model.write("model.lp"); // Debug dump of the named model
         }
 
-        // Latency variable
-        GRBVar latencyVar = model.addVar(1, maxLatency, 0, GRB_INTEGER, "latency");
-
-        // Constraints:
-
-        // 1. Each operation must be scheduled exactly once
-        for (Node* node : operationNodes) {
-            GRBLinExpr expr = 0;
-            for (int t = 1; t <= maxLatency; ++t) {
-                expr += x[node][t - 1];
-            }
-            model.addConstr(expr == 1, "sched_once_" + node->name);
-        }
-
-        // 2. Dependency Constraints
-        for (Node* node : operationNodes) {
-            for (Node* pred : node->inputs) {
-                int opTypePred = getOperationType(pred);
-                if (opTypePred == -1) {
-                    // pred is INPUT node
-                    // Node cannot start before time 1
-                    // No need to add constraint since x[node][t] is defined for t >= 1
-                    continue;
-                } else {
-                    // For all possible times
-                    for (int t = 1; t <= maxLatency; ++t) {
-                        GRBLinExpr expr = 0;
-                        for (int tp = 1; tp <= t - 1; ++tp) {
-                            expr += x[pred][tp - 1];
-                        }
-                        model.addConstr(x[node][t - 1] <= expr, "dep_" + pred->name + "_" + node->name + "_t" + std::to_string(t));
-                    }
-                }
-            }
-        }
-
-        // 3. Resource Constraints
-        for (int t = 1; t <= maxLatency; ++t) {
-            GRBLinExpr andExpr = 0, orExpr = 0, notExpr = 0;
-            for (Node* node : operationNodes) {
-                int opType = getOperationType(node);
-                if (opType == 0) {
-                    andExpr += x[node][t - 1];
-                } else if (opType == 1) {
-                    orExpr += x[node][t - 1];
-                } else if (opType == 2) {
-                    notExpr += x[node][t - 1];
-                }
-            }
-            model.addConstr(andExpr <= andLimit, "and_limit_t" + std::to_string(t));
-            model.addConstr(orExpr <= orLimit, "or_limit_t" + std::to_string(t));
-            model.addConstr(notExpr <= notLimit, "not_limit_t" + std::to_string(t));
-        }
-
-        // 4. Latency Constraints
-        for (Node* node : operationNodes) {
-            GRBLinExpr sum = 0;
-            for (int t = 1; t <= maxLatency; ++t) {
-                sum += t * x[node][t - 1];
-            }
-            model.addConstr(latencyVar >= sum, "latency_constr_" + node->name);
-        }
-
-        // For OUTPUT nodes
-        for (Node* node : graph->outputs) {
-            for (Node* pred : node->inputs) {
-                int opTypePred = getOperationType(pred);
-                if (opTypePred == -1) {
-                    // pred is INPUT node
-                    model.addConstr(latencyVar >= 1, "output_dep_input_" + pred->name + "_" + node->name);
-                } else {
-                    GRBLinExpr sum = 0;
-                    for (int t = 1; t <= maxLatency; ++t) {
-                        sum += t * x[pred][t - 1];
-                    }
-                    model.addConstr(latencyVar >= sum, "output_dep_" + pred->name + "_" + node->name);
-                }
-            }
-        }
-
-        // Objective: Minimize latency
-        model.setObjective(GRBLinExpr(latencyVar), GRB_MINIMIZE);
-
         // Set initial solution from heuristic scheduler
-        for (Node* node : operationNodes) {
-            int t = heuristicScheduler.getNodeTime(node);
+        std::vector<double> start(x.size(), 0.0);
+        for (size_t i = 0; i < operationNodes.size(); ++i) {
+            int t = heuristicScheduler.getNodeTime(operationNodes[i]);
             if (t != -1) {
-                x[node][t - 1].set(GRB_DoubleAttr_Start, 1.0);
+                start[i * horizon + (t - 1)] = 1.0;
             }
         }
+        model.set(GRB_DoubleAttr_Start, x.data(), start.data(), static_cast<int>(x.size()));
         latencyVar.set(GRB_DoubleAttr_Start, heuristicLatency);
 
         // Optimize model
@@ -158,6 +262,9 @@ void ILPScheduler::exactSchedule() {
 
         if (model.get(GRB_IntAttr_Status) == GRB_INFEASIBLE) {
             std::cout << "Model is infeasible" << std::endl;
+            if (!modelNames) {
+                nameModel(model); // Names are only needed for the IIS dump
+            }
             model.computeIIS();
             model.write("infeasible.ilp");
             return;
@@ -166,15 +273,17 @@ void ILPScheduler::exactSchedule() {
         // Extract the schedule
         latency = static_cast<int>(latencyVar.get(GRB_DoubleAttr_X) + 0.5);
         schedule.resize(latency);
-        for (Node* node : operationNodes) {
+        double* values = model.get(GRB_DoubleAttr_X, x.data(), static_cast<int>(x.size()));
+        for (size_t i = 0; i < operationNodes.size(); ++i) {
             for (int t = 1; t <= latency; ++t) {
-                if (x[node][t - 1].get(GRB_DoubleAttr_X) > 0.5) {
-                    nodeTime[node] = t;
-                    schedule[t - 1].push_back(node);
+                if (values[i * horizon + (t - 1)] > 0.5) {
+                    nodeTime[operationNodes[i]] = t;
+                    schedule[t - 1].push_back(operationNodes[i]);
                     break; // Node is scheduled exactly once
                 }
             }
         }
+        delete[] values;
 
     } catch (GRBException& e) {
         std::cerr << "Gurobi Error code = " << e.getErrorCode() << std::endl;
@@ -12,12 +12,32 @@ public:
     void exactSchedule();
     void printSchedule() const;
 
+    // Build the ILP for time steps 1..maxLatency into model without solving it
+    void buildModel(GRBModel& model, int maxLatency);
+    // Attach readable variable/constraint names to a model built by buildModel
+    void nameModel(GRBModel& model) const;
+    // Name every variable and constraint and write model.lp before solving (debugging only)
+    void setModelNames(bool enable) { modelNames = enable; }
+
 private:
     Graph* graph;
     int andLimit, orLimit, notLimit;
     int latency;
+    bool modelNames;
     std::map<Node*, int> nodeTime;
     std::vector<std::vector<Node*>> schedule;
 
+    // Flat model state: x[i * horizon + (t - 1)] = 1 if operationNodes[i] starts at time t
+    int horizon;
+    std::vector<Node*> operationNodes;
+    std::vector<int> operationTypes;
+    std::vector<GRBVar> x;
+    GRBVar latencyVar;
+
+    // Nonzeros buffered before a batch of rows is passed to Gurobi
+    static const size_t maxBatchTerms = 1 << 20;
+    // Constraint names assigned per attribute call in nameModel
+    static const size_t maxBatchNames = 1 << 16;
+
     int getOperationType(Node* node) const;
 };
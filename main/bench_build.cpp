@@ -0,0 +1,168 @@
+// bench_build.cpp
+// Times ILP model construction (no solve) for a BLIF file: the original
+// string-named, map-based build against buildModel with and without names
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include "Graph.h"
+#include "Scheduler.h"
+#include "ILPScheduler.h"
+
+static int getOperationType(Node* node) {
+    if (node->type == "AND") return 0;
+    if (node->type == "OR") return 1;
+    if (node->type == "NOT") return 2;
+    return -1; // INPUT or OUTPUT
+}
+
+// Baseline: the model construction exactSchedule used before buildModel
+static void buildLegacyModel(Graph& graph, int andLimit, int orLimit, int notLimit,
+                             GRBModel& model, int maxLatency) {
+    std::vector<Node*> operationNodes;
+    for (auto& pair : graph.nodes) {
+        if (getOperationType(pair.second) != -1) {
+            operationNodes.push_back(pair.second);
+        }
+    }
+
+    std::map<Node*, std::vector<GRBVar>> x;
+    for (Node* node : operationNodes) {
+        std::vector<GRBVar> varList;
+        for (int t = 1; t <= maxLatency; ++t) {
+            varList.push_back(model.addVar(0, 1, 0, GRB_BINARY, "x_" + node->name + "_" + std::to_string(t)));
+        }
+        x[node] = varList;
+    }
+    GRBVar latencyVar = model.addVar(1, maxLatency, 0, GRB_INTEGER, "latency");
+
+    for (Node* node : operationNodes) {
+        GRBLinExpr expr = 0;
+        for (int t = 1; t <= maxLatency; ++t) {
+            expr += x[node][t - 1];
+        }
+        model.addConstr(expr == 1, "sched_once_" + node->name);
+    }
+
+    for (Node* node : operationNodes) {
+        for (Node* pred : node->inputs) {
+            if (getOperationType(pred) == -1) continue;
+            for (int t = 1; t <= maxLatency; ++t) {
+                GRBLinExpr expr = 0;
+                for (int tp = 1; tp <= t - 1; ++tp) {
+                    expr += x[pred][tp - 1];
+                }
+                model.addConstr(x[node][t - 1] <= expr, "dep_" + pred->name + "_" + node->name + "_t" + std::to_string(t));
+            }
+        }
+    }
+
+    for (int t = 1; t <= maxLatency; ++t) {
+        GRBLinExpr andExpr = 0, orExpr = 0, notExpr = 0;
+        for (Node* node : operationNodes) {
+            int opType = getOperationType(node);
+            if (opType == 0) {
+                andExpr += x[node][t - 1];
+            } else if (opType == 1) {
+                orExpr += x[node][t - 1];
+            } else if (opType == 2) {
+                notExpr += x[node][t - 1];
+            }
+        }
+        model.addConstr(andExpr <= andLimit, "and_limit_t" + std::to_string(t));
+        model.addConstr(orExpr <= orLimit, "or_limit_t" + std::to_string(t));
+        model.addConstr(notExpr <= notLimit, "not_limit_t" + std::to_string(t));
+    }
+
+    for (Node* node : operationNodes) {
+        GRBLinExpr sum = 0;
+        for (int t = 1; t <= maxLatency; ++t) {
+            sum += t * x[node][t - 1];
+        }
+        model.addConstr(latencyVar >= sum, "latency_constr_" + node->name);
+    }
+
+    for (Node* node : graph.outputs) {
+        for (Node* pred : node->inputs) {
+            if (getOperationType(pred) == -1) {
+                model.addConstr(latencyVar >= 1, "output_dep_input_" + pred->name + "_" + node->name);
+            } else {
+                GRBLinExpr sum = 0;
+                for (int t = 1; t <= maxLatency; ++t) {
+                    sum += t * x[pred][t - 1];
+                }
+                model.addConstr(latencyVar >= sum, "output_dep_" + pred->name + "_" + node->name);
+            }
+        }
+    }
+
+    model.setObjective(GRBLinExpr(latencyVar), GRB_MINIMIZE);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 5 || argc > 7) {
+        std::cerr << "Usage: mlrcs_bench BLIF_FILE AND_CONSTRAINT OR_CONSTRAINT NOT_CONSTRAINT [MAX_HORIZON [REPEATS]]" << std::endl;
+        return 1;
+    }
+
+    std::string blifFile = argv[1];
+    int andConstraint = std::stoi(argv[2]);
+    int orConstraint = std::stoi(argv[3]);
+    int notConstraint = std::stoi(argv[4]);
+    int maxHorizon = argc >= 6 ? std::stoi(argv[5]) : 0; // 0: no cap
+    int repeats = argc == 7 ? std::stoi(argv[6]) : 3;
+
+    Graph graph;
+    graph.parseBLIF(blifFile);
+
+    // Same time horizon exactSchedule uses, optionally capped to keep the model buildable
+    Scheduler heuristicScheduler(&graph, andConstraint, orConstraint, notConstraint);
+    heuristicScheduler.heuristicSchedule();
+    int maxLatency = heuristicScheduler.getLatency();
+    if (maxHorizon > 0) {
+        maxLatency = std::min(maxLatency, maxHorizon);
+    }
+
+    try {
+        GRBEnv env = GRBEnv(true);
+        env.set("LogFile", "");
+        env.set("OutputFlag", "0");
+        env.start();
+
+        ILPScheduler ilpScheduler(&graph, andConstraint, orConstraint, notConstraint);
+        const char* modes[3] = { "legacy", "unnamed", "named" };
+        double best[3] = { 0, 0, 0 };
+        for (int r = 0; r < repeats; ++r) {
+            for (int mode = 0; mode < 3; ++mode) {
+                GRBModel model = GRBModel(env);
+                auto begin = std::chrono::steady_clock::now();
+                if (mode == 0) {
+                    buildLegacyModel(graph, andConstraint, orConstraint, notConstraint, model, maxLatency);
+                } else {
+                    ilpScheduler.buildModel(model, maxLatency);
+                    if (mode == 2) {
+                        ilpScheduler.nameModel(model);
+                    }
+                }
+                model.update(); // Flush pending rows so Gurobi's own work is counted
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+                if (r == 0 || elapsed.count() < best[mode]) best[mode] = elapsed.count();
+                if (r == 0 && mode == 0) {
+                    std::cout << "Horizon: " << maxLatency
+                              << ", variables: " << model.get(GRB_IntAttr_NumVars)
+                              << ", constraints: " << model.get(GRB_IntAttr_NumConstrs)
+                              << ", nonzeros: " << model.get(GRB_DoubleAttr_DNumNZs) << std::endl;
+                }
+            }
+        }
+        for (int mode = 0; mode < 3; ++mode) {
+            std::cout << "Build (" << modes[mode] << "): " << best[mode] << " ms" << std::endl;
+        }
+    } catch (GRBException& e) {
+        std::cerr << "Gurobi Error code = " << e.getErrorCode() << std::endl;
+        std::cerr << e.getMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
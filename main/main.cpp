@@ -5,8 +5,8 @@
 #include "ILPScheduler.h"
 
 int main(int argc, char* argv[]) {
-    if (argc != 6) {
-        std::cerr << "Usage: mlrcs -h/-e BLIF_FILE AND_CONSTRAINT OR_CONSTRAINT NOT_CONSTRAINT" << std::endl;
+    if (argc != 6 && !(argc == 7 && std::string(argv[6]) == "-n")) {
+        std::cerr << "Usage: mlrcs -h/-e BLIF_FILE AND_CONSTRAINT OR_CONSTRAINT NOT_CONSTRAINT [-n]" << std::endl;
         return 1;
     }
 
@@ -15,6 +15,7 @@ int main(int argc, char* argv[]) {
     int andConstraint = std::stoi(argv[3]);
     int orConstraint = std::stoi(argv[4]);
     int notConstraint = std::stoi(argv[5]);
+    bool modelNames = argc == 7; // -n: name the ILP model and dump it to model.lp
 
     Graph graph;
     graph.parseBLIF(blifFile);
@@ -27,6 +28,7 @@ int main(int argc, char* argv[]) {
         scheduler.printSchedule();
     } else if (option == "-e") {
         ILPScheduler ilpScheduler(&graph, andConstraint, orConstraint, notConstraint);
+        ilpScheduler.setModelNames(modelNames);
         ilpScheduler.exactSchedule();
         ilpScheduler.printSchedule();
     } else {